@@ -0,0 +1,158 @@
+#!/bin/sh
+# Benchmark head, tail and findlocation against GNU head/tail and grep.
+#
+# Usage: bench/bench.sh [-q] [-r reps] [-o results.tsv] [-b baseline.tsv] [-t pct]
+#
+#   -q            quick run with small datasets
+#   -r reps       timed runs per case (default 15, plus 2 warmup runs)
+#   -o file       also write the results table to file
+#   -b file       compare p50 against a previous results file and exit 1
+#                 when any case got slower by more than -t percent (default 10)
+#                 and by more than 0.2 ms, so sub-millisecond jitter is ignored
+#
+# Everything is built and generated under $BENCH_DIR (default /tmp/oshw1-bench).
+# Pin the run with e.g. `taskset -c 2 bench/bench.sh` for steadier numbers.
+
+set -eu
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+BENCH_DIR=${BENCH_DIR:-/tmp/oshw1-bench}
+CC=${CC:-cc}
+CFLAGS=${CFLAGS:--O2}
+
+REPS=15
+QUICK=0
+OUT=
+BASELINE=
+THRESHOLD=10
+
+while getopts qr:o:b:t: opt; do
+    case $opt in
+    q) QUICK=1 ;;
+    r) REPS=$OPTARG ;;
+    o) OUT=$OPTARG ;;
+    b) BASELINE=$OPTARG ;;
+    t) THRESHOLD=$OPTARG ;;
+    *) sed -n '2,14p' "$0" >&2; exit 1 ;;
+    esac
+done
+
+export LC_ALL=C
+mkdir -p "$BENCH_DIR"
+BIN=$BENCH_DIR/bin
+DATA=$BENCH_DIR/data
+mkdir -p "$BIN" "$DATA"
+
+# build the tools under test and the helpers
+$CC $CFLAGS -o "$BIN/head" "$ROOT/src/head.c" "$ROOT/src/my_functions.c"
+$CC $CFLAGS -o "$BIN/tail" "$ROOT/src/tail.c" "$ROOT/src/my_functions.c"
+$CC $CFLAGS -o "$BIN/findlocation" "$ROOT/src/findlocation.c" "$ROOT/src/my_functions.c"
+$CC $CFLAGS -o "$BIN/gen_log" "$ROOT/bench/gen_log.c" -lm
+$CC $CFLAGS -o "$BIN/gen_nanpa" "$ROOT/bench/gen_nanpa.c"
+$CC $CFLAGS -o "$BIN/runstat" "$ROOT/bench/runstat.c"
+
+if [ "$QUICK" -eq 1 ]; then
+    LOG_BYTES=4000000
+    NANPA_COUNT=100000
+else
+    LOG_BYTES=16000000
+    NANPA_COUNT=1000000
+fi
+
+# datasets are deterministic (fixed seed), so only regenerate on size change
+gen() {
+    target=$1; shift
+    if [ ! -s "$target" ] || [ "$(cat "$target.args" 2>/dev/null)" != "$*" ]; then
+        "$@" > "$target"
+        echo "$*" > "$target.args"
+    fi
+}
+gen "$DATA/uniform.log" "$BIN/gen_log" "$LOG_BYTES" 20 200 uniform
+gen "$DATA/exp.log" "$BIN/gen_log" "$LOG_BYTES" 10 4000 exp
+gen "$DATA/nanpa" "$BIN/gen_nanpa" "$NANPA_COUNT"
+
+# last record: worst case for the linear scan
+LAST_PREFIX=$(tail -c 32 "$DATA/nanpa" | cut -c1-6)
+NUMBER=${LAST_PREFIX}1234
+
+# 2000 numbers spread over the dataset for findlocation -f, and the same
+# prefixes as anchored patterns for grep
+awk -v n="$NANPA_COUNT" 'NR % int(n / 2000 + 1) == 0 { print substr($0, 1, 6) "1234" }' \
+    "$DATA/nanpa" > "$DATA/numbers"
+sed 's/^\(......\).*/^\1/' "$DATA/numbers" > "$DATA/patterns"
+
+RESULTS=$BENCH_DIR/results.tsv
+printf 'case\tp50_ms\tp90_ms\tp99_ms\tmin_ms\tmb_per_s\tmax_rss_kb\n' > "$RESULTS"
+
+# run [-e] <name> <mode> <data> <cache> cmd...
+# -e marks commands that stop before the end of the data; they get no
+# throughput figure
+run() {
+    early=
+    if [ "$1" = -e ]; then
+        early=-e
+        shift
+    fi
+    name=$1 mode=$2 data=$3 cache=$4; shift 4
+    cold=
+    [ "$cache" = cold ] && cold=-c
+    line=$("$BIN/runstat" -r "$REPS" $cold $early -m "$mode" -d "$data" -- "$@")
+    printf '%s\t%s\n' "$name/$mode/$cache" "$line" >> "$RESULTS"
+}
+
+for log in uniform exp; do
+    f=$DATA/$log.log
+    for cache in warm cold; do
+        run -e "head-n17-$log" arg "$f" $cache "$BIN/head" -n 17 "$f"
+        run -e "gnuhead-n17-$log" arg "$f" $cache head -n 17 "$f"
+        run "head-all-$log" arg "$f" $cache "$BIN/head" -n 2000000000 "$f"
+        run "gnuhead-all-$log" arg "$f" $cache head -n 2000000000 "$f"
+        run "tail-n10-$log" arg "$f" $cache "$BIN/tail" -n 10 "$f"
+        # GNU tail seeks to the end of a regular file
+        run -e "gnutail-n10-$log" arg "$f" $cache tail -n 10 "$f"
+
+        run "head-all-$log" file "$f" $cache "$BIN/head" -n 2000000000
+        run "gnuhead-all-$log" file "$f" $cache head -n 2000000000
+        run "tail-n10-$log" file "$f" $cache "$BIN/tail" -n 10
+        run -e "gnutail-n10-$log" file "$f" $cache tail -n 10
+
+        run "head-all-$log" pipe "$f" $cache "$BIN/head" -n 2000000000
+        run "gnuhead-all-$log" pipe "$f" $cache head -n 2000000000
+        run "tail-n10-$log" pipe "$f" $cache "$BIN/tail" -n 10
+        run "gnutail-n10-$log" pipe "$f" $cache tail -n 10
+    done
+done
+
+# findlocation on a regular file (argument or redirected stdin) does a
+# binary search and grep -m1 stops at the match, so those are early exits
+f=$DATA/nanpa
+for cache in warm cold; do
+    run -e findlocation arg "$f" $cache "$BIN/findlocation" "$NUMBER" "$f"
+    run -e findlocation file "$f" $cache "$BIN/findlocation" "$NUMBER"
+    run findlocation pipe "$f" $cache "$BIN/findlocation" "$NUMBER"
+    run -e grep arg "$f" $cache grep -m1 "^$LAST_PREFIX" "$f"
+    run -e grep file "$f" $cache grep -m1 "^$LAST_PREFIX"
+    run -e grep pipe "$f" $cache grep -m1 "^$LAST_PREFIX"
+    run -e findlocation-f2000 arg "$f" $cache "$BIN/findlocation" -f "$DATA/numbers" "$f"
+    run -e findlocation-f2000 file "$f" $cache "$BIN/findlocation" -f "$DATA/numbers"
+    run findlocation-f2000 pipe "$f" $cache "$BIN/findlocation" -f "$DATA/numbers"
+    run grep-f2000 file "$f" $cache grep -f "$DATA/patterns"
+    run grep-f2000 pipe "$f" $cache grep -f "$DATA/patterns"
+done
+
+column -t -s "$(printf '\t')" "$RESULTS" 2>/dev/null || cat "$RESULTS"
+[ -n "$OUT" ] && cp "$RESULTS" "$OUT"
+
+if [ -n "$BASELINE" ]; then
+    # cases present in both files; p50 regression beyond the threshold fails
+    awk -F '\t' -v t="$THRESHOLD" '
+        NR == FNR { if (FNR > 1) base[$1] = $2; next }
+        FNR > 1 && ($1 in base) && base[$1] > 0 {
+            pct = ($2 - base[$1]) / base[$1] * 100
+            flag = (pct > t && $2 - base[$1] > 0.2) ? "REGRESSION" : ""
+            if (flag != "") bad++
+            printf "%-32s %10.3f -> %10.3f ms %+7.1f%% %s\n", $1, base[$1], $2, pct, flag
+        }
+        END { exit bad > 0 }
+    ' "$BASELINE" "$RESULTS"
+fi
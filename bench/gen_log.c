@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+/*
+ * gen_log: write a synthetic log of roughly <bytes> bytes to stdout.
+ *
+ * Usage: gen_log <bytes> <min_len> <max_len> [fixed|uniform|exp] [seed]
+ *
+ * Line lengths (without the '\n') are drawn from the chosen distribution
+ * and clamped to [min_len, max_len]. "exp" gives mostly short lines with a
+ * long tail, which is what real logs look like.
+ */
+
+#define DEFAULT_SEED 42
+
+static uint64_t rng_state;
+
+// xorshift64*, small and good enough for test data
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 2685821657736338717ULL;
+}
+
+static double next_unit(void) {
+    return (next_rand() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static void usage(void) {
+    fprintf(stderr, "Usage: gen_log <bytes> <min_len> <max_len> [fixed|uniform|exp] [seed]\n");
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 4) {
+        usage();
+        return 1;
+    }
+
+    long long total = atoll(argv[1]);
+    long min_len = atol(argv[2]);
+    long max_len = atol(argv[3]);
+    const char *dist = argc > 4 ? argv[4] : "uniform";
+    rng_state = argc > 5 ? strtoull(argv[5], NULL, 10) : DEFAULT_SEED;
+    if (rng_state == 0) rng_state = DEFAULT_SEED;
+
+    if (total < 0 || min_len < 0 || max_len < min_len) {
+        usage();
+        return 1;
+    }
+    if (strcmp(dist, "fixed") != 0 && strcmp(dist, "uniform") != 0 && strcmp(dist, "exp") != 0) {
+        usage();
+        return 1;
+    }
+
+    static const char *levels[] = { "INFO ", "DEBUG", "WARN ", "ERROR" };
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyz0123456789 =:/-_.";
+
+    char *line = malloc(max_len + 1);
+    if (!line) {
+        fprintf(stderr, "Memory allocation error\n");
+        return 1;
+    }
+
+    long long written = 0;
+    unsigned long seq = 0;
+    while (written < total) {
+        long len;
+        if (strcmp(dist, "fixed") == 0) {
+            len = max_len;
+        } else if (strcmp(dist, "uniform") == 0) {
+            len = min_len + (long)(next_rand() % (uint64_t)(max_len - min_len + 1));
+        } else {
+            // mean sits a quarter of the way into the range
+            double mean = (max_len - min_len) / 4.0 + 1.0;
+            len = min_len - (long)(mean * log(1.0 - next_unit()));
+            if (len > max_len) len = max_len;
+        }
+
+        // timestamp-ish header followed by random payload
+        int hdr = snprintf(line, max_len + 1, "%010lu %s ", seq++, levels[next_rand() % 4]);
+        if (hdr > len) hdr = len;
+        for (long i = hdr; i < len; i++) {
+            line[i] = alphabet[next_rand() % (sizeof(alphabet) - 1)];
+        }
+        line[len] = '\n';
+
+        if (fwrite(line, 1, len + 1, stdout) != (size_t)(len + 1)) {
+            fprintf(stderr, "Error writing to stdout\n");
+            free(line);
+            return 1;
+        }
+        written += len + 1;
+    }
+
+    free(line);
+    return 0;
+}
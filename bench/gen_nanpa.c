@@ -0,0 +1,73 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+/*
+ * gen_nanpa: write <count> NANPA records to stdout in the same layout
+ * findlocation expects: 6-digit prefix, 25-byte space padded location and
+ * a newline, 32 bytes per record, sorted by prefix.
+ *
+ * Usage: gen_nanpa <count> [seed]      (count <= 1000000)
+ */
+
+#define LINE_SIZE 32
+#define PREFIX_SIZE 6
+#define LOCATION_SIZE 25
+#define MAX_PREFIXES 1000000
+#define DEFAULT_SEED 42
+
+static uint64_t rng_state;
+
+static uint64_t next_rand(void) {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 2685821657736338717ULL;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: gen_nanpa <count> [seed]\n");
+        return 1;
+    }
+
+    long count = atol(argv[1]);
+    rng_state = argc > 2 ? strtoull(argv[2], NULL, 10) : DEFAULT_SEED;
+    if (rng_state == 0) rng_state = DEFAULT_SEED;
+    if (count < 0 || count > MAX_PREFIXES) {
+        fprintf(stderr, "count must be between 0 and %d\n", MAX_PREFIXES);
+        return 1;
+    }
+
+    static const char *cities[] = {
+        "Midland", "Alma", "Manistee Ri", "Saginaw", "Bay City", "Durand",
+        "Rose City", "Clare", "Owosso", "Grace Harbo", "West Branch", "Ovid",
+        "Standish", "McBrides", "Mount Pleas", "Elkton", "Gladwin", "Remus",
+    };
+    static const char *states[] = { "MI", "TX", "NM", "CA", "NY", "OH", "WA", "FL" };
+
+    // Selection sampling (Knuth, Algorithm S) keeps the output sorted and
+    // duplicate free without holding the whole key space in memory.
+    long needed = count;
+    char record[LINE_SIZE + 1];
+    for (long key = 0; key < MAX_PREFIXES && needed > 0; key++) {
+        if ((long)(next_rand() % (uint64_t)(MAX_PREFIXES - key)) >= needed) {
+            continue;
+        }
+        needed--;
+
+        int n = snprintf(record, sizeof(record), "%06ld%s %s", key,
+                         cities[next_rand() % (sizeof(cities) / sizeof(cities[0]))],
+                         states[next_rand() % (sizeof(states) / sizeof(states[0]))]);
+        for (int i = n; i < PREFIX_SIZE + LOCATION_SIZE; i++) {
+            record[i] = ' ';
+        }
+        record[LINE_SIZE - 1] = '\n';
+
+        if (fwrite(record, 1, LINE_SIZE, stdout) != LINE_SIZE) {
+            fprintf(stderr, "Error writing to stdout\n");
+            return 1;
+        }
+    }
+    return 0;
+}
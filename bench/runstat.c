@@ -0,0 +1,205 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+/*
+ * runstat: run a command repeatedly and report latency percentiles,
+ * throughput and peak RSS of the measured process.
+ *
+ * Usage: runstat [-r reps] [-w warmup] [-c] [-e] [-m arg|file|pipe] -d data -- cmd [args...]
+ *
+ *   -d data   input file; used for throughput, cache dropping and stdin
+ *   -m arg    the command opens data itself (it is already in argv)
+ *   -m file   stdin is redirected from data
+ *   -m pipe   stdin is a pipe fed by a separate writer process
+ *   -c        cold cache: evict data from the page cache before every run
+ *   -e        the command stops early (reads only part of data), so
+ *             leave the throughput column empty
+ *
+ * stdout of the command goes to /dev/null. One tab separated line is printed:
+ *   p50_ms p90_ms p99_ms min_ms mb_per_s max_rss_kb
+ * where mb_per_s is the data size divided by the median run time, or empty
+ * with -e.
+ */
+
+#define DEFAULT_REPS 15
+#define DEFAULT_WARMUP 2
+#define FEED_CHUNK 65536
+
+enum input_mode { MODE_ARG, MODE_FILE, MODE_PIPE };
+
+static void usage(void) {
+    fprintf(stderr, "Usage: runstat [-r reps] [-w warmup] [-c] [-e] [-m arg|file|pipe] -d data -- cmd [args...]\n");
+}
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+// Drop clean pages of the file; works without root unlike drop_caches.
+static void evict_file(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+// Writer side of the pipe; exits when the reader goes away.
+static void feed_pipe(const char *path, int out_fd) {
+    static char buffer[FEED_CHUNK];
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) _exit(1);
+    ssize_t n;
+    while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+        char *p = buffer;
+        while (n > 0) {
+            ssize_t w = write(out_fd, p, n);
+            if (w == -1) _exit(errno == EPIPE ? 0 : 1);
+            p += w;
+            n -= w;
+        }
+    }
+    _exit(0);
+}
+
+// Runs the command once; returns wall time in ms or -1 on failure.
+static double run_once(char **cmd, enum input_mode mode, const char *data, long *max_rss) {
+    int pipe_fds[2] = { -1, -1 };
+    pid_t feeder = -1;
+
+    if (mode == MODE_PIPE) {
+        if (pipe(pipe_fds) == -1) return -1;
+        feeder = fork();
+        if (feeder == -1) return -1;
+        if (feeder == 0) {
+            close(pipe_fds[0]);
+            feed_pipe(data, pipe_fds[1]);
+        }
+        close(pipe_fds[1]);
+    }
+
+    double start = now_ms();
+    pid_t pid = fork();
+    if (pid == -1) return -1;
+    if (pid == 0) {
+        int devnull = open("/dev/null", O_WRONLY);
+        if (devnull != -1) dup2(devnull, STDOUT_FILENO);
+        if (mode == MODE_FILE) {
+            int in = open(data, O_RDONLY);
+            if (in == -1) _exit(127);
+            dup2(in, STDIN_FILENO);
+        } else if (mode == MODE_PIPE) {
+            dup2(pipe_fds[0], STDIN_FILENO);
+        }
+        execvp(cmd[0], cmd);
+        _exit(127);
+    }
+    if (mode == MODE_PIPE) close(pipe_fds[0]);
+
+    int status;
+    struct rusage usage_info;
+    if (wait4(pid, &status, 0, &usage_info) == -1) return -1;
+    double elapsed = now_ms() - start;
+
+    if (feeder != -1) waitpid(feeder, NULL, 0);
+
+    if (!WIFEXITED(status) || WEXITSTATUS(status) == 127) {
+        return -1;
+    }
+    if (usage_info.ru_maxrss > *max_rss) *max_rss = usage_info.ru_maxrss;
+    return elapsed;
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile over sorted samples
+static double percentile(const double *sorted, int n, double p) {
+    int rank = (int)(p / 100.0 * n + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > n) rank = n;
+    return sorted[rank - 1];
+}
+
+int main(int argc, char *argv[]) {
+    int reps = DEFAULT_REPS, warmup = DEFAULT_WARMUP, cold = 0, early_exit = 0;
+    enum input_mode mode = MODE_ARG;
+    const char *data = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "+r:w:cem:d:")) != -1) {
+        switch (opt) {
+        case 'r': reps = atoi(optarg); break;
+        case 'w': warmup = atoi(optarg); break;
+        case 'c': cold = 1; break;
+        case 'e': early_exit = 1; break;
+        case 'd': data = optarg; break;
+        case 'm':
+            if (strcmp(optarg, "arg") == 0) mode = MODE_ARG;
+            else if (strcmp(optarg, "file") == 0) mode = MODE_FILE;
+            else if (strcmp(optarg, "pipe") == 0) mode = MODE_PIPE;
+            else { usage(); return 1; }
+            break;
+        default:
+            usage();
+            return 1;
+        }
+    }
+    if (data == NULL || optind >= argc || reps < 1 || warmup < 0) {
+        usage();
+        return 1;
+    }
+    char **cmd = &argv[optind];
+
+    struct stat st;
+    if (stat(data, &st) == -1) {
+        fprintf(stderr, "runstat: cannot stat %s\n", data);
+        return 1;
+    }
+
+    double *samples = malloc(reps * sizeof(double));
+    if (!samples) {
+        fprintf(stderr, "Memory allocation error\n");
+        return 1;
+    }
+
+    long max_rss = 0;
+    for (int i = 0; i < warmup + reps; i++) {
+        if (cold) evict_file(data);
+        double t = run_once(cmd, mode, data, &max_rss);
+        if (t < 0) {
+            fprintf(stderr, "runstat: failed to run %s\n", cmd[0]);
+            free(samples);
+            return 1;
+        }
+        if (i >= warmup) samples[i - warmup] = t;
+    }
+
+    qsort(samples, reps, sizeof(double), cmp_double);
+    double p50 = percentile(samples, reps, 50);
+    char mbps[32] = "";
+    if (!early_exit && p50 > 0) {
+        snprintf(mbps, sizeof(mbps), "%.1f", (st.st_size / 1e6) / (p50 / 1000.0));
+    }
+
+    printf("%.3f\t%.3f\t%.3f\t%.3f\t%s\t%ld\n",
+           p50, percentile(samples, reps, 90), percentile(samples, reps, 99),
+           samples[0], mbps, max_rss);
+
+    free(samples);
+    return 0;
+}
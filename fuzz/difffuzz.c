@@ -0,0 +1,895 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include "../src/my_functions.h"
+
+/*
+ * difffuzz: differential fuzzer for head, tail, findlocation and the
+ * my_functions primitives.
+ *
+ * Usage: difffuzz -b bindir [-j threads] [-i iterations] [-s seed] [-T] [-g] [-o faildir]
+ *
+ *   -b bindir      directory holding the head, tail and findlocation binaries
+ *   -j threads     worker threads (default: number of online CPUs)
+ *   -i iterations  inputs per thread (default 2000)
+ *   -s seed        base seed; thread k uses seed + k, so runs are repeatable
+ *   -T             expect GNU tail output on inputs with NUL bytes; by default
+ *                  tail is held to its known behaviour of cutting each output
+ *                  line at the first NUL, and such inputs are only counted
+ *   -g             also run the growth check for superlinear time or memory
+ *   -o faildir     where failing inputs are written (default: .)
+ *
+ * Every generated input is run through each tool three ways: as a filename
+ * argument, as redirected stdin and as a pipe written in random short
+ * chunks so that read() returns partial lines. The output must match the
+ * in-process reference byte for byte.
+ *
+ * findlocation gets its own NANPA-style datasets with duplicate, non-digit
+ * and high-byte prefixes and a trailing partial record. Single-number and
+ * -f answers are checked against a first-match reference. Piped input runs
+ * with both the SIMD and the scalar scan; sorted datasets also go through
+ * the binary search as a file argument and as redirected stdin.
+ */
+
+#define DEFAULT_ITERATIONS 2000
+#define DEFAULT_SEED 1
+#define READ_BUFFER 1024        // buffer size used by head.c and tail.c
+#define CPU_LIMIT_SECONDS 20
+#define GROWTH_BASE_SIZE (128 * 1024)
+#define GROWTH_SCALE 8
+#define GROWTH_SLACK 3          // allowed factor over linear growth
+#define GROWTH_MIN_MS 30.0      // ignore timings below this, they are noise
+#define GROWTH_MIN_RSS_KB 1024
+#define LINE_SIZE 32            // findlocation record layout
+#define PREFIX_SIZE 6
+#define LOCATION_SIZE 25
+#define NUMBER_SIZE 10
+
+enum input_mode { MODE_ARG, MODE_FILE, MODE_PIPE };
+static const char *mode_names[] = { "arg", "file", "pipe" };
+
+struct buf {
+    char *data;
+    size_t len, cap;
+};
+
+struct worker {
+    int id;
+    uint64_t rng;
+    long failures;
+    long runs;
+    long iteration;
+    long known_issues;      // tail inputs that hit the NUL truncation
+    struct buf report;      // mismatches for the current input
+};
+
+static char *scalar_env[] = { "FINDLOCATION_NO_SIMD=1", NULL };
+static const char *bin_dir;
+static const char *fail_dir = ".";
+static long iterations = DEFAULT_ITERATIONS;
+static int strict_tail = 0;
+static pthread_mutex_t report_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const char *tmp_dir(void) {
+    const char *tmp = getenv("TMPDIR");
+    return tmp && *tmp ? tmp : "/tmp";
+}
+
+static uint64_t next_rand(uint64_t *state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 2685821657736338717ULL;
+}
+
+static size_t rand_below(uint64_t *state, size_t n) {
+    return n ? next_rand(state) % n : 0;
+}
+
+static void buf_push(struct buf *b, const void *src, size_t n) {
+    if (b->len + n > b->cap) {
+        size_t cap = b->cap ? b->cap : 256;
+        while (cap < b->len + n) cap *= 2;
+        char *data = realloc(b->data, cap);
+        if (!data) {
+            fprintf(stderr, "Memory allocation error\n");
+            exit(2);
+        }
+        b->data = data;
+        b->cap = cap;
+    }
+    memcpy(b->data + b->len, src, n);
+    b->len += n;
+}
+
+static void buf_putc(struct buf *b, char c) {
+    buf_push(b, &c, 1);
+}
+
+// Replaces the contents of an open temporary file
+static int fill_file(int fd, const struct buf *b) {
+    if (ftruncate(fd, 0) == -1) return -1;
+    return pwrite(fd, b->data, b->len, 0) == (ssize_t)b->len ? 0 : -1;
+}
+
+/* ---- input generation ---- */
+
+// Line length biased towards the cases that have broken before: empty
+// lines and lines that straddle the 1024-byte read buffer.
+static size_t pick_line_length(uint64_t *rng) {
+    size_t roll = rand_below(rng, 100);
+    if (roll < 15) return 0;
+    if (roll < 60) return rand_below(rng, 80);
+    if (roll < 80) return READ_BUFFER - 3 + rand_below(rng, 6);
+    if (roll < 95) return rand_below(rng, 6 * READ_BUFFER);
+    return rand_below(rng, 64 * READ_BUFFER);
+}
+
+static void generate_input(uint64_t *rng, struct buf *in) {
+    in->len = 0;
+    size_t lines;
+    size_t roll = rand_below(rng, 100);
+    if (roll < 5) lines = 0;
+    else if (roll < 85) lines = rand_below(rng, 40);
+    else lines = rand_below(rng, 3000);
+
+    int crlf = rand_below(rng, 100) < 30;
+    int nul_rate = rand_below(rng, 100) < 20 ? 1 + rand_below(rng, 50) : 0;
+
+    for (size_t i = 0; i < lines; i++) {
+        size_t len = lines > 200 ? rand_below(rng, 80) : pick_line_length(rng);
+        for (size_t j = 0; j < len; j++) {
+            char c = ' ' + rand_below(rng, 95);
+            if (nul_rate && rand_below(rng, 1000) < (size_t)nul_rate) c = '\0';
+            else if (rand_below(rng, 500) == 0) c = '\r';
+            buf_putc(in, c);
+        }
+        if (crlf) buf_putc(in, '\r');
+        buf_putc(in, '\n');
+    }
+
+    // a final line without the trailing newline
+    if (rand_below(rng, 100) < 30) {
+        size_t len = pick_line_length(rng);
+        for (size_t j = 0; j < len; j++) {
+            buf_putc(in, 'a' + rand_below(rng, 26));
+        }
+    }
+}
+
+/* ---- reference implementations ---- */
+
+static void ref_head(const struct buf *in, long n, struct buf *out) {
+    size_t end = 0;
+    long seen = 0;
+    while (end < in->len && seen < n) {
+        if (in->data[end++] == '\n') seen++;
+    }
+    out->len = 0;
+    buf_push(out, in->data, end);
+}
+
+// A trailing partial line counts as a line, as in GNU tail. tail.c keeps
+// lines as C strings, so it prints each one only up to its first NUL;
+// truncate_at_nul models that. Returns 1 if any output line was cut.
+static int ref_tail(const struct buf *in, long n, int truncate_at_nul, struct buf *out) {
+    size_t start = in->len;
+    long seen = 0;
+    if (start > 0 && in->data[start - 1] != '\n') seen = 1;
+    while (start > 0) {
+        if (in->data[start - 1] == '\n') {
+            if (seen == n) break;
+            seen++;
+        }
+        start--;
+    }
+    if (seen < n) start = 0;
+    out->len = 0;
+    if (!truncate_at_nul) {
+        buf_push(out, in->data + start, in->len - start);
+        return 0;
+    }
+
+    int cut = 0;
+    while (start < in->len) {
+        const char *line = in->data + start;
+        const char *nl = memchr(line, '\n', in->len - start);
+        size_t len = nl ? (size_t)(nl - line) + 1 : in->len - start;
+        const char *nul = memchr(line, '\0', len);
+        if (nul) cut = 1;
+        buf_push(out, line, nul ? (size_t)(nul - line) : len);
+        start += len;
+    }
+    return cut;
+}
+
+/* ---- running the tools ---- */
+
+// Child side of the pipe: write the input in random small chunks with short
+// pauses so that the reader sees partial lines. Only async-signal-safe calls.
+static void feed_chunks(const struct buf *in, int fd, uint64_t seed) {
+    size_t max_chunk = 1 + rand_below(&seed, 3) * READ_BUFFER + rand_below(&seed, 17);
+    size_t pos = 0;
+    while (pos < in->len) {
+        size_t n = 1 + rand_below(&seed, max_chunk);
+        if (n > in->len - pos) n = in->len - pos;
+        ssize_t w = write(fd, in->data + pos, n);
+        if (w == -1) _exit(errno == EPIPE ? 0 : 1);
+        pos += w;
+        if (rand_below(&seed, 4) == 0) {
+            struct timespec pause = { 0, (long)rand_below(&seed, 50000) };
+            nanosleep(&pause, NULL);
+        }
+    }
+    _exit(0);
+}
+
+// Plain copy of a file into the pipe, used for the timing runs
+static void feed_file(const char *path, int fd) {
+    char chunk[65536];
+    int in = open(path, O_RDONLY);
+    if (in == -1) _exit(1);
+    ssize_t n;
+    while ((n = read(in, chunk, sizeof(chunk))) > 0) {
+        for (ssize_t pos = 0; pos < n;) {
+            ssize_t w = write(fd, chunk + pos, n - pos);
+            if (w == -1) _exit(errno == EPIPE ? 0 : 1);
+            pos += w;
+        }
+    }
+    _exit(0);
+}
+
+/*
+ * Runs bin_dir/tool with argv, feeding input per mode. envp replaces the
+ * environment unless it is NULL. With in == NULL the
+ * pipe is fed from path instead of from memory. Output is collected
+ * in out, or dropped when out is NULL. Wall time and peak RSS of the tool
+ * are returned through the pointers. Returns the exit status, -1 if the
+ * tool died from a signal or -2 if the run could not be set up.
+ */
+static int run_tool(const char *tool, char *const args[], char *const envp[], enum input_mode mode,
+                    const char *path, const struct buf *in, uint64_t seed,
+                    struct buf *out, double *elapsed_ms, long *max_rss_kb) {
+    char exe[4096];
+    snprintf(exe, sizeof(exe), "%s/%s", bin_dir, tool);
+
+    char *argv[8];
+    int argc = 0;
+    argv[argc++] = exe;
+    for (int i = 0; args[i]; i++) argv[argc++] = args[i];
+    if (mode == MODE_ARG) argv[argc++] = (char *)path;
+    argv[argc] = NULL;
+
+    int out_pipe[2], in_pipe[2] = { -1, -1 };
+    if (pipe2(out_pipe, O_CLOEXEC) == -1) return -2;
+    if (mode == MODE_PIPE && pipe2(in_pipe, O_CLOEXEC) == -1) {
+        close(out_pipe[0]);
+        close(out_pipe[1]);
+        return -2;
+    }
+
+    pid_t feeder = -1;
+    if (mode == MODE_PIPE) {
+        feeder = fork();
+        if (feeder == -1) {
+            close(out_pipe[0]);
+            close(out_pipe[1]);
+            close(in_pipe[0]);
+            close(in_pipe[1]);
+            return -2;
+        }
+        if (feeder == 0) {
+            // Drop every descriptor other threads opened, or a feeder could
+            // keep another run's pipes alive and stall it.
+            signal(SIGPIPE, SIG_IGN);
+            dup2(in_pipe[1], STDOUT_FILENO);
+            close_range(STDERR_FILENO + 1, ~0U, 0);
+            if (in == NULL) feed_file(path, STDOUT_FILENO);
+            feed_chunks(in, STDOUT_FILENO, seed);
+        }
+        close(in_pipe[1]);
+    }
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    pid_t pid = fork();
+    if (pid == -1) {
+        close(out_pipe[0]);
+        close(out_pipe[1]);
+        if (mode == MODE_PIPE) {
+            // the feeder gets EPIPE once the read end is gone
+            close(in_pipe[0]);
+            waitpid(feeder, NULL, 0);
+        }
+        return -2;
+    }
+    if (pid == 0) {
+        struct rlimit cpu = { CPU_LIMIT_SECONDS, CPU_LIMIT_SECONDS };
+        setrlimit(RLIMIT_CPU, &cpu);
+        dup2(out_pipe[1], STDOUT_FILENO);
+        // stderr is not compared; keep "Prefix not found" and friends quiet
+        int quiet = open("/dev/null", O_WRONLY);
+        if (quiet != -1) dup2(quiet, STDERR_FILENO);
+        if (mode == MODE_FILE) {
+            int fd = open(path, O_RDONLY);
+            if (fd == -1) _exit(126);
+            dup2(fd, STDIN_FILENO);
+        } else if (mode == MODE_PIPE) {
+            dup2(in_pipe[0], STDIN_FILENO);
+        } else {
+            int fd = open("/dev/null", O_RDONLY);
+            if (fd != -1) dup2(fd, STDIN_FILENO);
+        }
+        close_range(STDERR_FILENO + 1, ~0U, 0);
+        if (envp) execve(exe, argv, envp);
+        else execv(exe, argv);
+        _exit(127);
+    }
+    close(out_pipe[1]);
+    if (mode == MODE_PIPE) close(in_pipe[0]);
+
+    if (out) out->len = 0;
+    char chunk[65536];
+    ssize_t n;
+    while ((n = read(out_pipe[0], chunk, sizeof(chunk))) != 0) {
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (out) buf_push(out, chunk, n);
+    }
+    close(out_pipe[0]);
+
+    int status = 0;
+    struct rusage usage_info;
+    pid_t reaped;
+    while ((reaped = wait4(pid, &status, 0, &usage_info)) == -1 && errno == EINTR) {
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if (feeder > 0) waitpid(feeder, NULL, 0);
+    if (reaped == -1) return -2;
+
+    if (elapsed_ms) *elapsed_ms = (t1.tv_sec - t0.tv_sec) * 1000.0 + (t1.tv_nsec - t0.tv_nsec) / 1e6;
+    if (max_rss_kb) *max_rss_kb = usage_info.ru_maxrss;
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+// Records one failing tool/mode pair for the current input
+static void note_mismatch(struct worker *w, const char *what) {
+    if (w->report.len > 0) buf_push(&w->report, "; ", 2);
+    buf_push(&w->report, what, strlen(what));
+    w->failures++;
+}
+
+// Writes the input once and lists every mismatch it caused
+static void save_failure(struct worker *w, const struct buf *in, const char *suffix) {
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/difffuzz-fail-%d-%ld.%s", fail_dir, w->id, w->iteration, suffix);
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd != -1) {
+        if (write(fd, in->data, in->len) != (ssize_t)in->len) path[0] = '\0';
+        close(fd);
+    }
+    pthread_mutex_lock(&report_lock);
+    fprintf(stderr, "MISMATCH %.*s (%zu bytes) -> %s\n", (int)w->report.len, w->report.data, in->len, path);
+    pthread_mutex_unlock(&report_lock);
+    w->report.len = 0;
+}
+
+static size_t first_difference(const struct buf *a, const struct buf *b) {
+    size_t i = 0;
+    while (i < a->len && i < b->len && a->data[i] == b->data[i]) i++;
+    return i;
+}
+
+static void check_tools(struct worker *w, const struct buf *in, const char *path) {
+    struct buf expected = { 0 }, actual = { 0 };
+    char count[32], what[256];
+
+    for (int t = 0; t < 2; t++) {
+        const char *tool = t == 0 ? "head" : "tail";
+        // head accepts -n 0, tail rejects it; no -n means 10 for both
+        long lines = rand_below(&w->rng, 50) + (t == 1);
+        int use_default = rand_below(&w->rng, 10) == 0;
+        if (use_default) lines = 10;
+        snprintf(count, sizeof(count), "%ld", lines);
+        char *args[3] = { "-n", count, NULL };
+        if (use_default) args[0] = NULL;
+
+        if (t == 0) ref_head(in, lines, &expected);
+        else if (ref_tail(in, lines, !strict_tail, &expected)) w->known_issues++;
+
+        for (int m = MODE_ARG; m <= MODE_PIPE; m++) {
+            uint64_t seed = next_rand(&w->rng);
+            int status = run_tool(tool, args, NULL, m, path, in, seed, &actual, NULL, NULL);
+            w->runs++;
+            if (status != 0 || actual.len != expected.len ||
+                memcmp(actual.data, expected.data, expected.len) != 0) {
+                snprintf(what, sizeof(what),
+                         "%s -n %ld via %s: status %d, %zu bytes out, %zu expected, first diff at %zu",
+                         tool, lines, mode_names[m], status, actual.len, expected.len,
+                         first_difference(&actual, &expected));
+                note_mismatch(w, what);
+            }
+        }
+    }
+    free(expected.data);
+    free(actual.data);
+}
+
+/* ---- my_functions primitives ---- */
+
+static int sign(int x) {
+    return (x > 0) - (x < 0);
+}
+
+static void primitive_failure(struct worker *w, const char *what) {
+    pthread_mutex_lock(&report_lock);
+    fprintf(stderr, "MISMATCH %s\n", what);
+    pthread_mutex_unlock(&report_lock);
+    w->failures++;
+}
+
+static void check_primitives(struct worker *w) {
+    char a[64], b[64], x[64], y[64], what[256];
+    uint64_t *rng = &w->rng;
+
+    // small alphabet so strings share long prefixes
+    size_t la = rand_below(rng, 12), lb = rand_below(rng, 12);
+    for (size_t i = 0; i < la; i++) a[i] = 'a' + rand_below(rng, 3);
+    for (size_t i = 0; i < lb; i++) b[i] = 'a' + rand_below(rng, 3);
+    a[la] = '\0';
+    b[lb] = '\0';
+
+    if (my_strlen(a) != strlen(a)) {
+        snprintf(what, sizeof(what), "my_strlen(\"%s\")", a);
+        primitive_failure(w, what);
+    }
+
+    size_t n = rand_below(rng, 14);
+    if (sign(str_n_cmp(a, b, n)) != sign(strncmp(a, b, n))) {
+        snprintf(what, sizeof(what), "str_n_cmp(\"%s\", \"%s\", %zu) = %d, strncmp gives %d",
+                 a, b, n, str_n_cmp(a, b, n), strncmp(a, b, n));
+        primitive_failure(w, what);
+    }
+    if (sign(str_cmp(a, b)) != sign(strcmp(a, b))) {
+        snprintf(what, sizeof(what), "str_cmp(\"%s\", \"%s\")", a, b);
+        primitive_failure(w, what);
+    }
+
+    for (size_t i = 0; i < sizeof(x); i++) x[i] = y[i] = (char)next_rand(rng);
+    n = rand_below(rng, sizeof(a));
+    if (my_memcpy(x, a, n) != x || (memcpy(y, a, n), memcmp(x, y, sizeof(x)) != 0)) {
+        snprintf(what, sizeof(what), "my_memcpy of %zu bytes", n);
+        primitive_failure(w, what);
+    }
+    int fill = (int)next_rand(rng);
+    n = rand_below(rng, sizeof(x));
+    if (my_memset(x, fill, n) != x || (memset(y, fill, n), memcmp(x, y, sizeof(x)) != 0)) {
+        snprintf(what, sizeof(what), "my_memset(%d, %zu)", fill, n);
+        primitive_failure(w, what);
+    }
+
+    // my_atoi: digits with an optional '+', -1 for anything invalid.
+    // At most 9 digits so the reference cannot overflow an int.
+    size_t len = 0;
+    size_t roll = rand_below(rng, 10);
+    if (roll == 0) a[len++] = '+';
+    else if (roll == 1) a[len++] = '-';
+    size_t digits = rand_below(rng, 10);
+    for (size_t i = 0; i < digits; i++) a[len++] = '0' + rand_below(rng, 10);
+    if (rand_below(rng, 10) == 0 && len > 0) a[rand_below(rng, len)] = 'x';
+    a[len] = '\0';
+
+    int expected = 0;
+    const char *p = a;
+    if (*p == '+') p++;
+    if (a[0] == '\0' || a[0] == '-') expected = -1;
+    for (; expected != -1 && *p; p++) {
+        if (*p < '0' || *p > '9') expected = -1;
+        else expected = expected * 10 + (*p - '0');
+    }
+    if (my_atoi(a) != expected) {
+        snprintf(what, sizeof(what), "my_atoi(\"%s\") = %d, expected %d", a, my_atoi(a), expected);
+        primitive_failure(w, what);
+    }
+}
+
+/* ---- findlocation ---- */
+
+// Builds a dataset of 32-byte records. Sorted datasets have unique digit
+// prefixes, as the binary search requires; the others get duplicates and
+// broken prefixes. Either may end in a partial record.
+static void generate_records(uint64_t *rng, int sorted, struct buf *db) {
+    static const char letters[] = "ABCDEFGHIJ abcdefghij";
+    db->len = 0;
+    size_t roll = rand_below(rng, 100);
+    size_t count = roll < 10 ? 0 : roll < 70 ? 1 + rand_below(rng, 64) : 64 + rand_below(rng, 2000);
+    size_t range = sorted ? count + rand_below(rng, 2 * count + 10) : 1 + rand_below(rng, 3 * count + 10);
+
+    size_t needed = count;
+    for (size_t next = 0; needed > 0; next++) {
+        size_t key;
+        if (sorted) {
+            // selection sampling keeps keys unique and in order
+            if (rand_below(rng, range - next) >= needed) continue;
+            key = next;
+        } else {
+            key = rand_below(rng, range);
+        }
+        needed--;
+
+        char record[LINE_SIZE];
+        snprintf(record, sizeof(record), "%06zu", key);
+        if (!sorted && rand_below(rng, 10) == 0) {
+            static const char broken[] = { '/', ':', ' ', '\0', (char)0xB0, (char)0xFF };
+            size_t at = rand_below(rng, PREFIX_SIZE);
+            record[at] = rand_below(rng, 2) ? broken[rand_below(rng, sizeof(broken))] : (char)next_rand(rng);
+        }
+        for (size_t i = PREFIX_SIZE; i < LINE_SIZE - 1; i++) {
+            record[i] = letters[rand_below(rng, sizeof(letters) - 1)];
+        }
+        record[LINE_SIZE - 1] = '\n';
+        buf_push(db, record, LINE_SIZE);
+    }
+
+    // a partial record; sorted files are mmap'd, which needs a size > 0
+    if (rand_below(rng, 100) < 30 || (sorted && db->len == 0)) {
+        size_t len = 1 + rand_below(rng, LINE_SIZE - 1);
+        for (size_t i = 0; i < len; i++) buf_putc(db, '0' + rand_below(rng, 10));
+    }
+}
+
+// First full record whose prefix matches number, or NULL
+static const char *ref_find(const struct buf *db, const char *number) {
+    for (size_t i = 0; i + LINE_SIZE <= db->len; i += LINE_SIZE) {
+        if (memcmp(db->data + i, number, PREFIX_SIZE) == 0) return db->data + i;
+    }
+    return NULL;
+}
+
+// The location as findlocation prints it: trailing spaces trimmed
+static void push_location(struct buf *out, const char *record) {
+    size_t len = LOCATION_SIZE;
+    while (len > 0 && (record[PREFIX_SIZE + len - 1] == ' ' || record[PREFIX_SIZE + len - 1] == '\n')) len--;
+    buf_push(out, record + PREFIX_SIZE, len);
+    buf_putc(out, '\n');
+}
+
+static void random_number(uint64_t *rng, const struct buf *db, char *number) {
+    size_t records = db->len / LINE_SIZE;
+    int digits = 0;
+    if (records > 0 && rand_below(rng, 100) < 70) {
+        const char *record = db->data + rand_below(rng, records) * LINE_SIZE;
+        memcpy(number, record, PREFIX_SIZE);
+        digits = 1;
+        for (int i = 0; i < PREFIX_SIZE; i++) {
+            if (number[i] < '0' || number[i] > '9') digits = 0;
+        }
+    }
+    if (!digits) {
+        snprintf(number, PREFIX_SIZE + 1, "%06u", (unsigned)(rand_below(rng, records * 3 + 10) % 1000000));
+    }
+    for (int i = PREFIX_SIZE; i < NUMBER_SIZE; i++) number[i] = '0' + rand_below(rng, 10);
+    number[NUMBER_SIZE] = '\0';
+}
+
+static void check_findlocation(struct worker *w, struct buf *db, struct buf *queries,
+                               int data_fd, const char *data_path, int query_fd, const char *query_path) {
+    int sorted = rand_below(&w->rng, 2);
+    generate_records(&w->rng, sorted, db);
+
+    size_t num_queries = rand_below(&w->rng, 20) == 0 ? 0 : 1 + rand_below(&w->rng, 40);
+    struct buf expected_many = { 0 }, expected_one = { 0 }, actual = { 0 };
+    char number[NUMBER_SIZE + 1], single[NUMBER_SIZE + 1], what[256];
+    int missing = 0;
+    queries->len = 0;
+    for (size_t q = 0; q < num_queries; q++) {
+        random_number(&w->rng, db, number);
+        buf_push(queries, number, NUMBER_SIZE);
+        if (rand_below(&w->rng, 5) == 0) buf_putc(queries, '\r');
+        buf_putc(queries, '\n');
+
+        const char *record = ref_find(db, number);
+        if (record) {
+            buf_push(&expected_many, number, NUMBER_SIZE);
+            buf_putc(&expected_many, ' ');
+            push_location(&expected_many, record);
+        } else {
+            missing = 1;
+        }
+    }
+    random_number(&w->rng, db, single);
+    const char *record = ref_find(db, single);
+    if (record) push_location(&expected_one, record);
+
+    if (fill_file(data_fd, db) == -1 || fill_file(query_fd, queries) == -1) {
+        note_mismatch(w, "findlocation: error writing temporary file");
+        return;
+    }
+
+    char *one_args[] = { single, NULL };
+    char *many_args[] = { "-f", (char *)query_path, NULL };
+    for (int m = MODE_ARG; m <= MODE_PIPE; m++) {
+        // the binary search only makes sense on sorted data
+        if (m != MODE_PIPE && !sorted) continue;
+        for (int scalar = 0; scalar <= (m == MODE_PIPE); scalar++) {
+            char *const *envp = scalar ? scalar_env : NULL;
+            for (int many = 0; many <= 1; many++) {
+                const struct buf *expected = many ? &expected_many : &expected_one;
+                int want = many ? missing : record == NULL;
+                int status = run_tool("findlocation", many ? many_args : one_args, envp, m, data_path,
+                                      db, next_rand(&w->rng), &actual, NULL, NULL);
+                w->runs++;
+                if (status != want || actual.len != expected->len ||
+                    memcmp(actual.data, expected->data, expected->len) != 0) {
+                    snprintf(what, sizeof(what),
+                             "findlocation %s via %s%s: status %d (want %d), %zu bytes out, %zu expected",
+                             many ? "-f" : single, mode_names[m], scalar ? " scalar" : "",
+                             status, want, actual.len, expected->len);
+                    note_mismatch(w, what);
+                }
+            }
+        }
+    }
+
+    if (w->report.len > 0) {
+        // the numbers file sits next to the saved dataset
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/difffuzz-fail-%d-%ld.numbers", fail_dir, w->id, w->iteration);
+        int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd != -1) {
+            if (fill_file(fd, queries) == -1) fprintf(stderr, "Error writing %s\n", path);
+            close(fd);
+        }
+        save_failure(w, db, "nanpa");
+    }
+    free(expected_many.data);
+    free(expected_one.data);
+    free(actual.data);
+}
+
+static void *worker_main(void *arg) {
+    struct worker *w = arg;
+    struct buf in = { 0 };
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/difffuzz-%d-XXXXXX", tmp_dir(), w->id);
+    int fd = mkstemp(path);
+    if (fd == -1) {
+        fprintf(stderr, "Error creating temporary file\n");
+        w->failures++;
+        return NULL;
+    }
+
+    struct buf db = { 0 }, queries = { 0 };
+    char query_path[4096];
+    snprintf(query_path, sizeof(query_path), "%s/difffuzz-%d-q-XXXXXX", tmp_dir(), w->id);
+    int query_fd = mkstemp(query_path);
+    if (query_fd == -1) {
+        fprintf(stderr, "Error creating temporary file\n");
+        w->failures++;
+        close(fd);
+        unlink(path);
+        return NULL;
+    }
+
+    for (w->iteration = 0; w->iteration < iterations; w->iteration++) {
+        generate_input(&w->rng, &in);
+        if (fill_file(fd, &in) == -1) {
+            fprintf(stderr, "Error writing temporary file\n");
+            w->failures++;
+            break;
+        }
+        check_tools(w, &in, path);
+        if (w->report.len > 0) save_failure(w, &in, "bin");
+        check_findlocation(w, &db, &queries, fd, path, query_fd, query_path);
+        for (int k = 0; k < 16; k++) check_primitives(w);
+    }
+
+    close(fd);
+    unlink(path);
+    close(query_fd);
+    unlink(query_path);
+    free(in.data);
+    free(db.data);
+    free(queries.data);
+    free(w->report.data);
+    return NULL;
+}
+
+/* ---- growth check ---- */
+
+// Writes size bytes of the given shape to fd. Goes through a small stack
+// buffer: ru_maxrss of a forked child starts at our own size, so we must
+// stay small while measuring.
+static int write_shape(int fd, int shape, size_t size) {
+    char chunk[4096];
+    size_t used = 0, written = 0;
+    if (ftruncate(fd, 0) == -1) return -1;
+    for (size_t i = 0; written + used < size; i++) {
+        switch (shape) {
+        case 0: chunk[used++] = 'x'; break;                         // one long line
+        case 1: chunk[used++] = i % 8 == 7 ? '\n' : 'y'; break;     // short lines
+        case 2: chunk[used++] = '\n'; break;                        // empty lines
+        default:                                                    // CRLF lines
+            if (i % 40 == 39) chunk[used++] = '\r';
+            chunk[used++] = i % 40 == 39 ? '\n' : 'z';
+            break;
+        }
+        if (used >= sizeof(chunk) - 1 || written + used >= size) {
+            if (pwrite(fd, chunk, used, written) != (ssize_t)used) return -1;
+            written += used;
+            used = 0;
+        }
+    }
+    return 0;
+}
+
+// Best of three runs, to keep scheduler noise out of the ratio.
+// Returns -1 if any run failed; its numbers would be meaningless.
+static int measure(const char *tool, char *const args[], enum input_mode mode, const char *path,
+                   double *ms, long *rss) {
+    *ms = -1;
+    *rss = 0;
+    for (int i = 0; i < 3; i++) {
+        double t;
+        long r;
+        if (run_tool(tool, args, NULL, mode, path, NULL, 0, NULL, &t, &r) != 0) {
+            return -1;
+        }
+        if (*ms < 0 || t < *ms) *ms = t;
+        if (r > *rss) *rss = r;
+    }
+    return 0;
+}
+
+static long check_growth(void) {
+    static const char *shape_names[] = { "long-line", "short-lines", "empty-lines", "crlf-lines" };
+    char *head_args[] = { "-n", "2000000000", NULL };
+    char *tail_args[] = { "-n", "10", NULL };
+    long flagged = 0;
+
+    char path_small[4096], path_large[4096], path_empty[4096];
+    snprintf(path_small, sizeof(path_small), "%s/difffuzz-growth-s-XXXXXX", tmp_dir());
+    snprintf(path_large, sizeof(path_large), "%s/difffuzz-growth-l-XXXXXX", tmp_dir());
+    snprintf(path_empty, sizeof(path_empty), "%s/difffuzz-growth-e-XXXXXX", tmp_dir());
+    int fd_small = mkstemp(path_small), fd_large = mkstemp(path_large), fd_empty = mkstemp(path_empty);
+    if (fd_small == -1 || fd_large == -1 || fd_empty == -1) {
+        fprintf(stderr, "Error creating temporary file\n");
+        return 1;
+    }
+
+    printf("%-6s %-12s %-5s %10s %10s %7s %10s %10s\n",
+           "tool", "shape", "mode", "small_ms", "large_ms", "ratio", "small_kb", "large_kb");
+
+    for (int shape = 0; shape < 4; shape++) {
+        if (write_shape(fd_small, shape, GROWTH_BASE_SIZE) == -1 ||
+            write_shape(fd_large, shape, GROWTH_BASE_SIZE * GROWTH_SCALE) == -1) {
+            fprintf(stderr, "Error writing temporary file\n");
+            flagged++;
+            break;
+        }
+
+        for (int t = 0; t < 2; t++) {
+            const char *tool = t == 0 ? "head" : "tail";
+            char **args = t == 0 ? head_args : tail_args;
+            for (int m = MODE_ARG; m <= MODE_PIPE; m += MODE_PIPE) {
+                double ms_small, ms_large, ms_empty;
+                long kb_small, kb_large, kb_empty;
+                if (measure(tool, args, m, path_empty, &ms_empty, &kb_empty) == -1 ||
+                    measure(tool, args, m, path_small, &ms_small, &kb_small) == -1 ||
+                    measure(tool, args, m, path_large, &ms_large, &kb_large) == -1) {
+                    printf("%-6s %-12s %-5s  RUN-FAILED\n", tool, shape_names[shape], mode_names[m]);
+                    flagged++;
+                    continue;
+                }
+
+                // compare growth over the cost of an empty input
+                double dt_small = ms_small - ms_empty, dt_large = ms_large - ms_empty;
+                long dk_small = kb_small - kb_empty, dk_large = kb_large - kb_empty;
+                double ratio = dt_small > 0 ? dt_large / dt_small : 0;
+
+                int slow = dt_large > GROWTH_MIN_MS &&
+                           dt_large > GROWTH_SLACK * GROWTH_SCALE * (dt_small > 1 ? dt_small : 1);
+                int fat = dk_large > GROWTH_MIN_RSS_KB &&
+                          dk_large > GROWTH_SLACK * GROWTH_SCALE * (dk_small > 64 ? dk_small : 64);
+
+                printf("%-6s %-12s %-5s %10.2f %10.2f %7.1f %10ld %10ld%s%s\n",
+                       tool, shape_names[shape], mode_names[m], ms_small, ms_large, ratio,
+                       kb_small, kb_large, slow ? "  SUPERLINEAR-TIME" : "",
+                       fat ? "  SUPERLINEAR-RSS" : "");
+                flagged += slow + fat;
+            }
+        }
+    }
+
+    close(fd_small);
+    close(fd_large);
+    close(fd_empty);
+    unlink(path_small);
+    unlink(path_large);
+    unlink(path_empty);
+    return flagged;
+}
+
+static void usage(void) {
+    fprintf(stderr, "Usage: difffuzz -b bindir [-j threads] [-i iterations] [-s seed] [-T] [-g] [-o faildir]\n");
+}
+
+int main(int argc, char *argv[]) {
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    uint64_t seed = DEFAULT_SEED;
+    int growth = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "b:j:i:s:Tgo:")) != -1) {
+        switch (opt) {
+        case 'b': bin_dir = optarg; break;
+        case 'j': threads = atol(optarg); break;
+        case 'i': iterations = atol(optarg); break;
+        case 's': seed = strtoull(optarg, NULL, 10); break;
+        case 'T': strict_tail = 1; break;
+        case 'g': growth = 1; break;
+        case 'o': fail_dir = optarg; break;
+        default:
+            usage();
+            return 2;
+        }
+    }
+    if (bin_dir == NULL || threads < 1 || iterations < 0) {
+        usage();
+        return 2;
+    }
+
+    // a tool exiting early must not kill us while we write to its pipe
+    signal(SIGPIPE, SIG_IGN);
+
+    struct worker *workers = calloc(threads, sizeof(struct worker));
+    pthread_t *tids = calloc(threads, sizeof(pthread_t));
+    if (!workers || !tids) {
+        fprintf(stderr, "Memory allocation error\n");
+        return 2;
+    }
+
+    for (long i = 0; i < threads; i++) {
+        workers[i].id = (int)i;
+        workers[i].rng = (seed + i) * 0x9E3779B97F4A7C15ULL | 1;
+        if (pthread_create(&tids[i], NULL, worker_main, &workers[i]) != 0) {
+            fprintf(stderr, "Error creating thread\n");
+            return 2;
+        }
+    }
+
+    long failures = 0, runs = 0, known_issues = 0;
+    for (long i = 0; i < threads; i++) {
+        pthread_join(tids[i], NULL);
+        failures += workers[i].failures;
+        runs += workers[i].runs;
+        known_issues += workers[i].known_issues;
+    }
+    printf("%ld tool runs over %ld inputs, %ld mismatches\n", runs, threads * iterations, failures);
+    if (known_issues > 0) {
+        // not a failure: rerun with -T to hold tail to GNU output
+        printf("%ld tail cases cut at NUL (known issue, see -T)\n", known_issues);
+    }
+
+    if (growth) {
+        failures += check_growth();
+    }
+
+    free(workers);
+    free(tids);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,25 @@
+#!/bin/sh
+# Build head, tail, findlocation and the differential fuzzer, then run it.
+#
+# Usage: fuzz/fuzz.sh [difffuzz options]
+#   e.g. fuzz/fuzz.sh -i 500 -g      500 inputs per thread plus growth check
+#        fuzz/fuzz.sh -s 7 -T        another seed, hold tail to GNU output on
+#                                    NUL bytes (fails until tail.c is fixed)
+#
+# Binaries go to $FUZZ_DIR (default /tmp/oshw1-fuzz); failing inputs are
+# written there too unless -o is given.
+
+set -eu
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+FUZZ_DIR=${FUZZ_DIR:-/tmp/oshw1-fuzz}
+CC=${CC:-cc}
+CFLAGS=${CFLAGS:--O2}
+
+mkdir -p "$FUZZ_DIR"
+$CC $CFLAGS -o "$FUZZ_DIR/head" "$ROOT/src/head.c" "$ROOT/src/my_functions.c"
+$CC $CFLAGS -o "$FUZZ_DIR/tail" "$ROOT/src/tail.c" "$ROOT/src/my_functions.c"
+$CC $CFLAGS -o "$FUZZ_DIR/findlocation" "$ROOT/src/findlocation.c" "$ROOT/src/my_functions.c"
+$CC $CFLAGS -pthread -o "$FUZZ_DIR/difffuzz" "$ROOT/fuzz/difffuzz.c" "$ROOT/src/my_functions.c"
+
+exec "$FUZZ_DIR/difffuzz" -b "$FUZZ_DIR" -o "$FUZZ_DIR" "$@"
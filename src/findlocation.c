@@ -5,11 +5,20 @@
 #include <sys/stat.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <stdint.h>
 #include "my_functions.h"
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define HAVE_AVX2_SCAN 1
+#endif
+
 #define LINE_SIZE 32 // Each line is exactly 32 bytes
 #define PREFIX_SIZE 6
 #define LOCATION_SIZE 25
+#define NUMBER_SIZE 10
+#define KEY_SPACE 1000000 // every 6-digit prefix
+#define BITMAP_WORDS ((KEY_SPACE + 31) / 32)
 
 // Function prototypes
 void display_usage();
@@ -18,17 +27,34 @@ off_t get_file_size(int fd);
 int binary_search(char *data, size_t num_records, const char *target_prefix, char *result_location);
 int linear_search(char *data, size_t data_size, const char *target_prefix, char *result_location);
 void trim_trailing_spaces(char *str);
+char *read_all(int fd, size_t *data_size);
+char *load_queries(const char *path, size_t *num_queries);
+int prefix_key(const char *prefix);
+size_t scan_records(const char *data, size_t num_records, const uint32_t *bitmap, size_t start);
+int find_many(char *data, size_t data_size, int sorted, char *numbers, size_t num_queries);
+
+// One bit per prefix, shared by the linear scans
+static uint32_t key_bitmap[BITMAP_WORDS];
 
 int main(int argc, char *argv[]) {
     int fd = -1; // File descriptor
     int use_stdin = 1; // Flag to check if we are using stdin
     char *filename = NULL;
     char *number = NULL;
+    char *queries_file = NULL; // -f: file with one 10-digit number per line
+    char *numbers = NULL; // Parsed queries, NUMBER_SIZE bytes each
+    size_t num_queries = 0;
     char result_location[LOCATION_SIZE + 1]; // +1 for null terminator
     char target_prefix[PREFIX_SIZE + 1]; // +1 for null terminator
 
     // Argument Parsing
-    if (argc == 2) {
+    if (argc >= 3 && str_cmp(argv[1], "-f") == 0) {
+        queries_file = argv[2];
+        if (argc >= 4) {
+            filename = argv[3];
+            use_stdin = 0;
+        }
+    } else if (argc == 2) {
         number = argv[1];
     } else if (argc >= 3) {
         number = argv[1];
@@ -39,15 +65,22 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    // Validate the number
-    if (!is_valid_number(number)) {
-        display_error("Invalid number format. Please provide a 10-digit number.");
-        return 1;
-    }
+    if (queries_file) {
+        numbers = load_queries(queries_file, &num_queries);
+        if (!numbers) {
+            return 1;
+        }
+    } else {
+        // Validate the number
+        if (!is_valid_number(number)) {
+            display_error("Invalid number format. Please provide a 10-digit number.");
+            return 1;
+        }
 
-    // Extract the first 6 digits to create the target prefix
-    my_memcpy(target_prefix, number, PREFIX_SIZE);
-    target_prefix[PREFIX_SIZE] = '\0';
+        // Extract the first 6 digits to create the target prefix
+        my_memcpy(target_prefix, number, PREFIX_SIZE);
+        target_prefix[PREFIX_SIZE] = '\0';
+    }
 
     // Open the file
     if (use_stdin) {
@@ -56,6 +89,7 @@ int main(int argc, char *argv[]) {
         fd = open(filename, O_RDONLY);
         if (fd == -1) {
             display_error("Error opening file");
+            free(numbers);
             return 1;
         }
     }
@@ -79,6 +113,7 @@ int main(int argc, char *argv[]) {
         if (file_size == -1) {
             display_error("Error getting file size");
             if (!use_stdin) close(fd);
+            free(numbers);
             return 1;
         }
 
@@ -87,12 +122,17 @@ int main(int argc, char *argv[]) {
         if (data == MAP_FAILED) {
             display_error("Error mapping file into memory");
             if (!use_stdin) close(fd);
+            free(numbers);
             return 1;
         }
 
         size_t num_records = file_size / LINE_SIZE;
 
-        result = binary_search(data, num_records, target_prefix, result_location);
+        if (numbers) {
+            result = find_many(data, file_size, 1, numbers, num_queries);
+        } else {
+            result = binary_search(data, num_records, target_prefix, result_location);
+        }
 
         // Unmap the memory
         if (munmap(data, file_size) == -1) {
@@ -100,46 +140,31 @@ int main(int argc, char *argv[]) {
         }
     } else {
         // Non-seekable file descriptor, read into buffer and use linear search
-        // We'll read the data into a dynamically allocated buffer
-        size_t buffer_size = 1024 * LINE_SIZE; // Initial buffer size
         size_t data_size = 0;
-        char *data = malloc(buffer_size);
+        char *data = read_all(fd, &data_size);
         if (!data) {
-            display_error("Memory allocation error");
             if (!use_stdin) close(fd);
+            free(numbers);
             return 1;
         }
 
-        ssize_t bytes_read;
-        while ((bytes_read = read(fd, data + data_size, buffer_size - data_size)) > 0) {
-            data_size += bytes_read;
-            if (data_size == buffer_size) {
-                // Need to increase buffer size
-                buffer_size *= 2;
-                char *temp = realloc(data, buffer_size);
-                if (!temp) {
-                    display_error("Memory reallocation error");
-                    free(data);
-                    if (!use_stdin) close(fd);
-                    return 1;
-                }
-                data = temp;
-            }
-        }
-        if (bytes_read == -1) {
-            display_error("Error reading file");
-            free(data);
-            if (!use_stdin) close(fd);
-            return 1;
+        if (numbers) {
+            result = find_many(data, data_size, 0, numbers, num_queries);
+        } else {
+            result = linear_search(data, data_size, target_prefix, result_location);
         }
 
-        result = linear_search(data, data_size, target_prefix, result_location);
-
         free(data);
     }
 
     if (!use_stdin) close(fd);
 
+    if (numbers) {
+        // find_many already printed every answer
+        free(numbers);
+        return result == 0 ? 0 : 1;
+    }
+
     if (result == 0) {
         // Trim trailing spaces
         trim_trailing_spaces(result_location);
@@ -156,6 +181,7 @@ int main(int argc, char *argv[]) {
 }
 void display_usage() {
     display_error("Usage: findlocation <10-digit-number> [filename]");
+    display_error("       findlocation -f <numbers-file> [filename]");
 }
 
 int is_valid_number(const char *str) {
@@ -188,6 +214,9 @@ off_t get_file_size(int fd) {
 }
 
 int binary_search(char *data, size_t num_records, const char *target_prefix, char *result_location) {
+    if (num_records == 0) {
+        return -1; // Only a partial record, nothing to search
+    }
     size_t left = 0;
     size_t right = num_records - 1;
     char prefix_buffer[PREFIX_SIZE + 1]; // +1 for null terminator
@@ -219,24 +248,24 @@ int binary_search(char *data, size_t num_records, const char *target_prefix, cha
 
 int linear_search(char *data, size_t data_size, const char *target_prefix, char *result_location) {
     size_t num_records = data_size / LINE_SIZE;
-    char prefix_buffer[PREFIX_SIZE + 1]; // +1 for null terminator
-
-    for (size_t i = 0; i < num_records; i++) {
-        char *record = data + (i * LINE_SIZE);
+    int key = prefix_key(target_prefix);
+    if (key < 0) {
+        return -1;
+    }
 
-        // Extract the prefix
-        my_memcpy(prefix_buffer, record, PREFIX_SIZE);
-        prefix_buffer[PREFIX_SIZE] = '\0';
+    // A one-key set; scan_records checks several records per step
+    key_bitmap[key / 32] |= 1u << (key % 32);
+    size_t i = scan_records(data, num_records, key_bitmap, 0);
+    key_bitmap[key / 32] &= ~(1u << (key % 32));
 
-        int cmp_result = str_n_cmp(prefix_buffer, target_prefix, PREFIX_SIZE);
-        if (cmp_result == 0) {
-            // Extract the location
-            my_memcpy(result_location, record + PREFIX_SIZE, LOCATION_SIZE);
-            result_location[LOCATION_SIZE] = '\0';
-            return 0; // Found
-        }
+    if (i == num_records) {
+        return -1; // Not found
     }
-    return -1; // Not found
+
+    // Extract the location
+    my_memcpy(result_location, data + (i * LINE_SIZE) + PREFIX_SIZE, LOCATION_SIZE);
+    result_location[LOCATION_SIZE] = '\0';
+    return 0; // Found
 }
 
 void trim_trailing_spaces(char *str) {
@@ -247,3 +276,294 @@ void trim_trailing_spaces(char *str) {
     }
 }
 
+// Reads fd to the end into a malloc'd buffer; NULL on error
+char *read_all(int fd, size_t *data_size) {
+    size_t buffer_size = 1024 * LINE_SIZE; // Initial buffer size
+    *data_size = 0;
+    char *data = malloc(buffer_size);
+    if (!data) {
+        display_error("Memory allocation error");
+        return NULL;
+    }
+
+    ssize_t bytes_read;
+    while ((bytes_read = read(fd, data + *data_size, buffer_size - *data_size)) > 0) {
+        *data_size += bytes_read;
+        if (*data_size == buffer_size) {
+            // Need to increase buffer size
+            buffer_size *= 2;
+            char *temp = realloc(data, buffer_size);
+            if (!temp) {
+                display_error("Memory reallocation error");
+                free(data);
+                return NULL;
+            }
+            data = temp;
+        }
+    }
+    if (bytes_read == -1) {
+        display_error("Error reading file");
+        free(data);
+        return NULL;
+    }
+    return data;
+}
+
+// Loads the -f file: one 10-digit number per line, blank lines and CRLF
+// allowed. Returns the numbers packed NUMBER_SIZE bytes apart.
+char *load_queries(const char *path, size_t *num_queries) {
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        display_error("Error opening numbers file");
+        return NULL;
+    }
+    size_t size = 0;
+    char *text = read_all(fd, &size);
+    close(fd);
+    if (!text) {
+        return NULL;
+    }
+
+    // Every number takes at least NUMBER_SIZE + 1 bytes except the last
+    char *numbers = malloc((size / (NUMBER_SIZE + 1) + 1) * NUMBER_SIZE);
+    if (!numbers) {
+        display_error("Memory allocation error");
+        free(text);
+        return NULL;
+    }
+
+    *num_queries = 0;
+    size_t pos = 0;
+    while (pos < size) {
+        size_t end = pos;
+        while (end < size && text[end] != '\n') end++;
+        size_t len = end - pos;
+        if (len > 0 && text[end - 1] == '\r') len--;
+
+        if (len > 0) {
+            char number[NUMBER_SIZE + 1];
+            int ok = len == NUMBER_SIZE;
+            if (ok) {
+                my_memcpy(number, text + pos, NUMBER_SIZE);
+                number[NUMBER_SIZE] = '\0';
+                ok = is_valid_number(number);
+            }
+            if (!ok) {
+                display_error("Invalid number format in numbers file. Expected one 10-digit number per line.");
+                free(numbers);
+                free(text);
+                return NULL;
+            }
+            my_memcpy(numbers + *num_queries * NUMBER_SIZE, number, NUMBER_SIZE);
+            (*num_queries)++;
+        }
+        pos = end + 1;
+    }
+
+    free(text);
+    return numbers;
+}
+
+// Maps a 6-digit prefix to 0..999999, or -1 if it is not all digits
+int prefix_key(const char *prefix) {
+    int key = 0;
+    for (int i = 0; i < PREFIX_SIZE; i++) {
+        if (prefix[i] < '0' || prefix[i] > '9') {
+            return -1;
+        }
+        key = key * 10 + (prefix[i] - '0');
+    }
+    return key;
+}
+
+#ifdef HAVE_AVX2_SCAN
+/*
+ * Eight records per step: two gathers over the 32-byte stride pick up
+ * prefix bytes 0-3 and 2-5, the digits are turned into keys with
+ * multiply-adds and a third gather tests the keys against the bitmap.
+ * Returns the first hit, or where the scalar loop has to take over.
+ */
+__attribute__((target("avx2")))
+static size_t scan_records_avx2(const char *data, size_t num_records, const uint32_t *bitmap, size_t start) {
+    const __m256i stride = _mm256_setr_epi32(0, 32, 64, 96, 128, 160, 192, 224);
+    const __m256i zeros = _mm256_set1_epi8('0');
+    const __m256i nine = _mm256_set1_epi8(9);
+    const __m256i tens = _mm256_set1_epi16(0x010A);       // d0 * 10 + d1
+    const __m256i hundreds = _mm256_set1_epi32(0x00010064); // p0 * 100 + p1
+    const __m256i hundred = _mm256_set1_epi32(100);
+    const __m256i low5 = _mm256_set1_epi32(31);
+    const __m256i ones = _mm256_set1_epi32(1);
+    const __m256i all = _mm256_set1_epi32(-1);
+
+    for (; start + 8 <= num_records; start += 8) {
+        const char *block = data + start * LINE_SIZE;
+        __m256i lo = _mm256_sub_epi8(_mm256_i32gather_epi32((const int *)block, stride, 1), zeros);
+        __m256i hi = _mm256_sub_epi8(_mm256_i32gather_epi32((const int *)(block + 2), stride, 1), zeros);
+
+        // digits are the bytes that are <= 9 (unsigned) after subtracting '0'
+        __m256i digits = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_min_epu8(lo, nine), lo),
+                                          _mm256_cmpeq_epi8(_mm256_min_epu8(hi, nine), hi));
+        __m256i valid = _mm256_cmpeq_epi32(digits, all);
+
+        __m256i first4 = _mm256_madd_epi16(_mm256_maddubs_epi16(lo, tens), hundreds);
+        __m256i last2 = _mm256_srli_epi32(_mm256_maddubs_epi16(hi, tens), 16);
+        __m256i key = _mm256_add_epi32(_mm256_mullo_epi32(first4, hundred), last2);
+        key = _mm256_and_si256(key, valid); // keep the bitmap gather in bounds
+
+        __m256i words = _mm256_i32gather_epi32((const int *)bitmap, _mm256_srli_epi32(key, 5), 4);
+        __m256i bits = _mm256_and_si256(_mm256_srlv_epi32(words, _mm256_and_si256(key, low5)), ones);
+        __m256i hit = _mm256_and_si256(_mm256_cmpeq_epi32(bits, ones), valid);
+
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(hit));
+        if (mask) {
+            return start + __builtin_ctz(mask);
+        }
+    }
+    return start;
+}
+#endif
+
+// Index of the first record at or after start whose prefix is set in
+// bitmap, or num_records if there is none
+size_t scan_records(const char *data, size_t num_records, const uint32_t *bitmap, size_t start) {
+#ifdef HAVE_AVX2_SCAN
+    static int use_avx2 = -1;
+    if (use_avx2 == -1) {
+        // FINDLOCATION_NO_SIMD forces the scalar loop, for testing
+        use_avx2 = __builtin_cpu_supports("avx2") && getenv("FINDLOCATION_NO_SIMD") == NULL;
+    }
+    if (use_avx2) {
+        start = scan_records_avx2(data, num_records, bitmap, start);
+    }
+#endif
+    for (size_t i = start; i < num_records; i++) {
+        int key = prefix_key(data + (i * LINE_SIZE));
+        if (key >= 0 && (bitmap[key / 32] >> (key % 32)) & 1) {
+            return i;
+        }
+    }
+    return num_records;
+}
+
+static int compare_keys(const void *a, const void *b) {
+    return *(const int *)a - *(const int *)b;
+}
+
+// Position of key in the sorted keys array, or -1
+static long find_key(const int *keys, size_t count, int key) {
+    size_t left = 0, right = count;
+    while (left < right) {
+        size_t mid = left + (right - left) / 2;
+        if (keys[mid] < key) {
+            left = mid + 1;
+        } else {
+            right = mid;
+        }
+    }
+    return (left < count && keys[left] == key) ? (long)left : -1;
+}
+
+// Prints "<number> <location>", or reports the number as not found when
+// location is NULL. location points at the record's LOCATION_SIZE bytes.
+static void print_answer(const char *number, const char *location) {
+    char line[NUMBER_SIZE + LOCATION_SIZE + 2];
+    my_memcpy(line, number, NUMBER_SIZE);
+    if (location == NULL) {
+        line[NUMBER_SIZE] = '\0';
+        my_file_puts(STDERR_FILENO, line);
+        display_error(": Prefix not found");
+        return;
+    }
+    line[NUMBER_SIZE] = ' ';
+    my_memcpy(line + NUMBER_SIZE + 1, location, LOCATION_SIZE);
+    line[NUMBER_SIZE + 1 + LOCATION_SIZE] = '\0';
+    trim_trailing_spaces(line);
+    size_t len = my_strlen(line);
+    line[len] = '\n';
+    if (write(STDOUT_FILENO, line, len + 1) == -1) {
+        display_error("Error writing to stdout");
+    }
+}
+
+/*
+ * Answers every number in one go. Sorted (mmap'd) data gets a binary
+ * search per number; piped data is scanned once against a bitmap of all
+ * wanted prefixes. Returns 0 if every number was found.
+ */
+int find_many(char *data, size_t data_size, int sorted, char *numbers, size_t num_queries) {
+    size_t num_records = data_size / LINE_SIZE;
+    int missing = 0;
+
+    if (num_queries == 0) {
+        return 0;
+    }
+
+    if (sorted) {
+        char prefix[PREFIX_SIZE + 1];
+        char location[LOCATION_SIZE + 1];
+        prefix[PREFIX_SIZE] = '\0';
+        for (size_t q = 0; q < num_queries; q++) {
+            const char *number = numbers + q * NUMBER_SIZE;
+            my_memcpy(prefix, number, PREFIX_SIZE);
+            if (binary_search(data, num_records, prefix, location) == 0) {
+                print_answer(number, location);
+            } else {
+                print_answer(number, NULL);
+                missing = 1;
+            }
+        }
+        return missing ? -1 : 0;
+    }
+
+    // Sorted unique keys; matches[i] is the first record for keys[i]
+    int *keys = malloc(num_queries * sizeof(int));
+    const char **matches = malloc(num_queries * sizeof(char *));
+    if (!keys || !matches) {
+        display_error("Memory allocation error");
+        free(keys);
+        free(matches);
+        return -1;
+    }
+    for (size_t q = 0; q < num_queries; q++) {
+        keys[q] = prefix_key(numbers + q * NUMBER_SIZE);
+    }
+    qsort(keys, num_queries, sizeof(int), compare_keys);
+    size_t num_keys = 0;
+    for (size_t q = 0; q < num_queries; q++) {
+        if (num_keys == 0 || keys[num_keys - 1] != keys[q]) {
+            keys[num_keys] = keys[q];
+            matches[num_keys] = NULL;
+            key_bitmap[keys[q] / 32] |= 1u << (keys[q] % 32);
+            num_keys++;
+        }
+    }
+
+    // One pass; a key's bit is cleared on its first match so later
+    // duplicates are skipped, as in linear_search
+    size_t remaining = num_keys;
+    size_t i = scan_records(data, num_records, key_bitmap, 0);
+    while (i < num_records && remaining > 0) {
+        const char *record = data + (i * LINE_SIZE);
+        int key = prefix_key(record);
+        matches[find_key(keys, num_keys, key)] = record;
+        key_bitmap[key / 32] &= ~(1u << (key % 32));
+        remaining--;
+        i = scan_records(data, num_records, key_bitmap, i + 1);
+    }
+    for (size_t k = 0; k < num_keys; k++) {
+        key_bitmap[keys[k] / 32] &= ~(1u << (keys[k] % 32));
+    }
+
+    for (size_t q = 0; q < num_queries; q++) {
+        const char *number = numbers + q * NUMBER_SIZE;
+        const char *record = matches[find_key(keys, num_keys, prefix_key(number))];
+        if (record == NULL) {
+            missing = 1;
+        }
+        print_answer(number, record ? record + PREFIX_SIZE : NULL);
+    }
+
+    free(keys);
+    free(matches);
+    return missing ? -1 : 0;
+}
@@ -85,7 +85,8 @@ int str_cmp(const char *s1, const char *s2) {
 int str_n_cmp(const char *s1, const char *s2, size_t n) {
   if (n == 0) return 0;
 
-  while (n-- && *s1 != '\0' && *s1 == *s2) {
+  while (*s1 != '\0' && *s1 == *s2) {
+    if (--n == 0) return 0; // first n characters matched
     s1++;
     s2++;
   }